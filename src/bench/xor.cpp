@@ -21,4 +21,18 @@ static void Xor(benchmark::Bench& bench)
     });
 }
 
+static void XorBlockKey(benchmark::Bench& bench)
+{
+    // Block files and LevelDB values use 8-byte keys.
+    FastRandomContext frc{/*fDeterministic=*/true};
+    auto data{frc.randbytes<std::byte>(1 << 20)};
+    auto key{frc.randbytes<std::byte>(8)};
+    size_t offset{0};
+
+    bench.batch(data.size()).unit("byte").run([&] {
+        util::Xor(data, key, offset++);
+    });
+}
+
 BENCHMARK(Xor, benchmark::PriorityLevel::HIGH);
+BENCHMARK(XorBlockKey, benchmark::PriorityLevel::HIGH);
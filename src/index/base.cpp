@@ -5,6 +5,7 @@
 #include <chainparams.h>
 #include <common/args.h>
 #include <index/base.h>
+#include <index/blockreadahead.h>
 #include <interfaces/chain.h>
 #include <kernel/chain.h>
 #include <logging.h>
@@ -145,6 +146,17 @@ void BaseIndex::Sync()
 {
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
+        // Declared before read_ahead so that it runs once the prepare threads
+        // have been joined.
+        struct PrepareCleanup {
+            BaseIndex& index;
+            ~PrepareCleanup() { index.CustomPrepareFinished(); }
+        } prepare_cleanup{*this};
+        BlockReadAhead::PrepareFn prepare;
+        if (AllowPrepare()) {
+            prepare = [this](const interfaces::BlockInfo& block) { CustomPrepare(block); };
+        }
+        BlockReadAhead read_ahead{m_chainstate->m_blockman, m_chainstate->m_chain, NeedsUndoData(), std::move(prepare), GetRecentSyncBlocks(), GetName()};
         std::chrono::steady_clock::time_point last_log_time{0s};
         std::chrono::steady_clock::time_point last_locator_write_time{0s};
         while (true) {
@@ -186,15 +198,14 @@ void BaseIndex::Sync()
             pindex = pindex_next;
 
 
-            CBlock block;
-            interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex);
-            if (!m_chainstate->m_blockman.ReadBlock(block, *pindex)) {
+            const SyncBlock entry{read_ahead.Get(*pindex)};
+            if (!entry.block) {
                 FatalErrorf("%s: Failed to read block %s from disk",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
-            } else {
-                block_info.data = &block;
             }
+            interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, entry.block.get());
+            block_info.undo_data = entry.undo.get();
             if (!CustomAppend(block_info)) {
                 FatalErrorf("%s: Failed to write block %s to index database",
                            __func__, pindex->GetBlockHash().ToString());
@@ -95,6 +95,14 @@ private:
 
     virtual bool AllowPrune() const = 0;
 
+    /// Whether CustomAppend needs the undo data of each block. If so, the sync
+    /// thread reads it ahead together with the block and passes it in
+    /// BlockInfo::undo_data.
+    virtual bool NeedsUndoData() const { return false; }
+
+    /// Whether CustomPrepare should be run for blocks read during sync.
+    virtual bool AllowPrepare() const { return false; }
+
     template <typename... Args>
     void FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args);
 
@@ -113,6 +121,16 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Compute index data for a block ahead of CustomAppend. Only called during
+    /// sync, from worker threads and possibly for several blocks at once, so it
+    /// must not depend on the index state. It may also be called for blocks that
+    /// end up never being appended, e.g. after a reorg.
+    virtual void CustomPrepare(const interfaces::BlockInfo& block) {}
+
+    /// Called when sync stops calling CustomPrepare, whether it completed or
+    /// not, to release anything prepared for blocks that were not appended.
+    virtual void CustomPrepareFinished() {}
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
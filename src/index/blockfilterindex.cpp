@@ -43,6 +43,8 @@ constexpr unsigned int FLTR_FILE_CHUNK_SIZE = 0x100000; // 1 MiB
  *  is big enough for a 2,000,000 length block chain, which
  *  we should be enough until ~2047. */
 constexpr size_t CF_HEADERS_CACHE_MAX_SZ{2000};
+/** Maximum number of filters built ahead of CustomAppend during sync. */
+constexpr size_t MAX_PREPARED_FILTERS{1000};
 
 namespace {
 
@@ -248,11 +250,39 @@ std::optional<uint256> BlockFilterIndex::ReadFilterHeader(int height, const uint
     return read_out.second.header;
 }
 
+void BlockFilterIndex::CustomPrepare(const interfaces::BlockInfo& block)
+{
+    // Only blocks read during sync come with undo data; the genesis block has none.
+    if (!block.undo_data && block.height > 0) return;
+    BlockFilter filter(m_filter_type, *Assert(block.data), block.undo_data ? *block.undo_data : CBlockUndo{});
+
+    LOCK(m_cs_prepared_filters);
+    // Filters for blocks that were never appended (e.g. read ahead on a stale
+    // branch) are not removed individually; just bound the map.
+    if (m_prepared_filters.size() >= MAX_PREPARED_FILTERS) m_prepared_filters.clear();
+    m_prepared_filters.insert_or_assign(block.hash, std::move(filter));
+}
+
+void BlockFilterIndex::CustomPrepareFinished()
+{
+    WITH_LOCK(m_cs_prepared_filters, m_prepared_filters.clear());
+}
+
 bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
 {
+    std::optional<BlockFilter> prepared;
+    {
+        LOCK(m_cs_prepared_filters);
+        if (auto node{m_prepared_filters.extract(block.hash)}) prepared = std::move(node.mapped());
+    }
+    if (prepared) return AppendFilter(*prepared, block.height);
+
     CBlockUndo block_undo;
+    const CBlockUndo* undo{&block_undo};
 
-    if (block.height > 0) {
+    if (block.undo_data) {
+        undo = block.undo_data;
+    } else if (block.height > 0) {
         // pindex variable gives indexing code access to node internals. It
         // will be removed in upcoming commit
         const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
@@ -261,10 +291,14 @@ bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
         }
     }
 
-    BlockFilter filter(m_filter_type, *Assert(block.data), block_undo);
+    BlockFilter filter(m_filter_type, *Assert(block.data), *undo);
+    return AppendFilter(filter, block.height);
+}
 
+bool BlockFilterIndex::AppendFilter(const BlockFilter& filter, int height)
+{
     const uint256& header = filter.ComputeHeader(m_last_header);
-    bool res = Write(filter, block.height, header);
+    bool res = Write(filter, height, header);
     if (res) m_last_header = header; // update last header
     return res;
 }
@@ -336,6 +370,9 @@ bool BlockFilterIndex::CustomRewind(const interfaces::BlockRef& current_tip, con
 
     // Update cached header
     m_last_header = *Assert(ReadFilterHeader(new_tip.height, new_tip.hash));
+
+    // Filters prepared for blocks on the old branch are of no use anymore.
+    WITH_LOCK(m_cs_prepared_filters, m_prepared_filters.clear());
     return true;
 }
 
@@ -45,10 +45,19 @@ private:
     // Last computed header to avoid disk reads on every new block.
     uint256 m_last_header{};
 
+    Mutex m_cs_prepared_filters;
+    /** Filters built ahead of CustomAppend during sync, by block hash. */
+    std::unordered_map<uint256, BlockFilter, FilterHeaderHasher> m_prepared_filters GUARDED_BY(m_cs_prepared_filters);
+
     bool AllowPrune() const override { return true; }
+    bool NeedsUndoData() const override { return true; }
+    bool AllowPrepare() const override { return true; }
 
     bool Write(const BlockFilter& filter, uint32_t block_height, const uint256& filter_header);
 
+    /** Chain the filter header to the previous one and write the filter. */
+    bool AppendFilter(const BlockFilter& filter, int height);
+
     std::optional<uint256> ReadFilterHeader(int height, const uint256& expected_block_hash);
 
 protected:
@@ -56,9 +65,13 @@ protected:
 
     bool CustomCommit(CDBBatch& batch) override;
 
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    void CustomPrepare(const interfaces::BlockInfo& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_cs_prepared_filters);
+
+    void CustomPrepareFinished() override EXCLUSIVE_LOCKS_REQUIRED(!m_cs_prepared_filters);
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_cs_prepared_filters);
 
-    bool CustomRewind(const interfaces::BlockRef& current_tip, const interfaces::BlockRef& new_tip) override;
+    bool CustomRewind(const interfaces::BlockRef& current_tip, const interfaces::BlockRef& new_tip) override EXCLUSIVE_LOCKS_REQUIRED(!m_cs_prepared_filters);
 
     BaseIndex::DB& GetDB() const LIFETIMEBOUND override { return *m_db; }
 
@@ -0,0 +1,197 @@
+// Copyright (c) 2026 The BTC-Prometheus developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/blockreadahead.h>
+
+#include <chain.h>
+#include <common/system.h>
+#include <core_memusage.h>
+#include <interfaces/chain.h>
+#include <kernel/chain.h>
+#include <kernel/cs_main.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <serialize.h>
+#include <undo.h>
+#include <util/thread.h>
+
+#include <algorithm>
+#include <utility>
+
+//! Maximum number of threads running the prepare function of a sync.
+static constexpr int MAX_SYNC_PREPARE_THREADS{8};
+
+SyncBlock RecentSyncBlocks::Get(const uint256& hash)
+{
+    LOCK(m_mutex);
+    auto it{m_blocks.find(hash)};
+    return it == m_blocks.end() ? SyncBlock{} : it->second.data;
+}
+
+void RecentSyncBlocks::Put(const uint256& hash, const SyncBlock& entry)
+{
+    // Undo data has no dynamic usage accounting; its serialized size is a
+    // close enough estimate.
+    const size_t block_usage{entry.block ? RecursiveDynamicUsage(*entry.block) : 0};
+    const size_t undo_usage{entry.undo ? ::GetSerializeSize(*entry.undo) : 0};
+
+    LOCK(m_mutex);
+    auto [it, inserted]{m_blocks.try_emplace(hash, Entry{entry, block_usage + undo_usage})};
+    if (!inserted) {
+        if (!it->second.data.undo && entry.undo) {
+            it->second.data.undo = entry.undo;
+            it->second.usage += undo_usage;
+            m_usage += undo_usage;
+        }
+    } else {
+        m_order.push_back(hash);
+        m_usage += it->second.usage;
+    }
+    // Always keep the newest entry, even if it exceeds the budget by itself.
+    while (m_usage > m_max_usage && m_order.size() > 1) {
+        auto oldest{m_blocks.find(m_order.front())};
+        m_usage -= oldest->second.usage;
+        m_blocks.erase(oldest);
+        m_order.pop_front();
+    }
+}
+
+std::shared_ptr<RecentSyncBlocks> GetRecentSyncBlocks()
+{
+    static Mutex mutex;
+    static std::weak_ptr<RecentSyncBlocks> current GUARDED_BY(mutex);
+
+    LOCK(mutex);
+    auto cache{current.lock()};
+    if (!cache) {
+        cache = std::make_shared<RecentSyncBlocks>(SYNC_SHARED_BLOCKS_BYTES);
+        current = cache;
+    }
+    return cache;
+}
+
+BlockReadAhead::BlockReadAhead(const node::BlockManager& blockman, const CChain& chain, bool read_undo, PrepareFn prepare,
+                               std::shared_ptr<RecentSyncBlocks> cache, const std::string& index_name)
+    : m_blockman{blockman},
+      m_chain{chain},
+      m_read_undo{read_undo},
+      m_prepare{std::move(prepare)},
+      m_cache{std::move(cache)},
+      m_read_thread_name{index_name + ".read"},
+      m_prepare_thread_name{index_name + ".prep"}
+{
+    m_thread_read = std::thread(&util::TraceThread, m_read_thread_name, [this] { ThreadRead(); });
+    if (m_prepare) {
+        const int num_threads{std::clamp(GetNumCores() - 1, 1, MAX_SYNC_PREPARE_THREADS)};
+        for (int i = 0; i < num_threads; ++i) {
+            m_threads_prepare.emplace_back(&util::TraceThread, m_prepare_thread_name, [this] { ThreadPrepare(); });
+        }
+    }
+}
+
+BlockReadAhead::~BlockReadAhead()
+{
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_cv.notify_all();
+    m_thread_read.join();
+    for (auto& thread : m_threads_prepare) thread.join();
+}
+
+SyncBlock BlockReadAhead::Read(const CBlockIndex& index) const
+{
+    SyncBlock entry{m_cache ? m_cache->Get(index.GetBlockHash()) : SyncBlock{}};
+    if (!entry.block) {
+        auto block{std::make_shared<CBlock>()};
+        if (!m_blockman.ReadBlock(*block, index)) return {};
+        entry.block = std::move(block);
+    }
+    // The genesis block has no undo data.
+    if (m_read_undo && !entry.undo && index.nHeight > 0) {
+        auto undo{std::make_shared<CBlockUndo>()};
+        if (!m_blockman.ReadBlockUndo(*undo, index)) return {};
+        entry.undo = std::move(undo);
+    }
+    if (m_cache) m_cache->Put(index.GetBlockHash(), entry);
+    return entry;
+}
+
+void BlockReadAhead::ThreadRead()
+{
+    while (true) {
+        const CBlockIndex* target;
+        uint64_t generation;
+        {
+            WAIT_LOCK(m_mutex, lock);
+            while (!m_stop && (!m_next || m_queue.size() >= SYNC_READ_AHEAD_BLOCKS)) {
+                m_cv.wait(lock);
+            }
+            if (m_stop) return;
+            target = m_next;
+            generation = m_generation;
+        }
+
+        SyncBlock entry{Read(*target)};
+        // Stop reading ahead after a failure; the sync loop handles it.
+        const CBlockIndex* next{entry.block ? WITH_LOCK(::cs_main, return m_chain.Next(target)) : nullptr};
+        const bool done{!m_prepare || !entry.block};
+        {
+            LOCK(m_mutex);
+            if (generation != m_generation) continue;
+            m_queue.push_back(std::make_shared<Slot>(Slot{.index = target, .entry = std::move(entry), .done = done}));
+            m_next = next;
+        }
+        m_cv.notify_all();
+    }
+}
+
+void BlockReadAhead::ThreadPrepare()
+{
+    while (true) {
+        std::shared_ptr<Slot> slot;
+        {
+            WAIT_LOCK(m_mutex, lock);
+            while (!m_stop && !slot) {
+                for (const auto& queued : m_queue) {
+                    if (!queued->done && !queued->preparing) {
+                        slot = queued;
+                        slot->preparing = true;
+                        break;
+                    }
+                }
+                if (!slot) m_cv.wait(lock);
+            }
+            if (m_stop) return;
+        }
+
+        interfaces::BlockInfo block_info{kernel::MakeBlockInfo(slot->index, slot->entry.block.get())};
+        block_info.undo_data = slot->entry.undo.get();
+        m_prepare(block_info);
+
+        WITH_LOCK(m_mutex, slot->done = true);
+        m_cv.notify_all();
+    }
+}
+
+SyncBlock BlockReadAhead::Get(const CBlockIndex& index)
+{
+    std::shared_ptr<Slot> slot;
+    {
+        WAIT_LOCK(m_mutex, lock);
+        const bool queued{!m_queue.empty() && m_queue.front()->index == &index};
+        if (!queued && !(m_queue.empty() && m_next == &index)) {
+            // Not what was read ahead (e.g. after a reorg); restart from this block.
+            m_queue.clear();
+            m_next = &index;
+            ++m_generation;
+            m_cv.notify_all();
+        }
+        while (m_queue.empty() || !m_queue.front()->done) {
+            m_cv.wait(lock);
+        }
+        slot = std::move(m_queue.front());
+        m_queue.pop_front();
+    }
+    m_cv.notify_all();
+    return slot->entry;
+}
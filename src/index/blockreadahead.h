@@ -0,0 +1,146 @@
+// Copyright (c) 2026 The BTC-Prometheus developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_BLOCKREADAHEAD_H
+#define BITCOIN_INDEX_BLOCKREADAHEAD_H
+
+#include <sync.h>
+#include <uint256.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+class CBlockUndo;
+class CChain;
+namespace interfaces {
+struct BlockInfo;
+} // namespace interfaces
+namespace node {
+class BlockManager;
+} // namespace node
+
+/** Number of blocks each index sync reads ahead of CustomAppend. */
+static constexpr size_t SYNC_READ_AHEAD_BLOCKS{8};
+/** Memory budget of the block cache shared by index syncs in progress. */
+static constexpr size_t SYNC_SHARED_BLOCKS_BYTES{32 << 20};
+
+/** A block read from disk for index sync, along with its undo data if requested. */
+struct SyncBlock {
+    std::shared_ptr<const CBlock> block;
+    std::shared_ptr<const CBlockUndo> undo;
+};
+
+/**
+ * Blocks recently read by index sync threads, bounded by memory usage. While
+ * several indexes sync at the same time and stay close to each other (e.g.
+ * right after they are enabled together), they reuse each other's reads
+ * instead of reading and deserializing the same block and undo data again.
+ * Indexes that drift apart by more than the budget read independently.
+ */
+class RecentSyncBlocks
+{
+    struct Entry {
+        SyncBlock data;
+        size_t usage;
+    };
+
+    const size_t m_max_usage;
+
+    mutable Mutex m_mutex;
+    std::map<uint256, Entry> m_blocks GUARDED_BY(m_mutex);
+    //! Insertion order of m_blocks, oldest first.
+    std::deque<uint256> m_order GUARDED_BY(m_mutex);
+    size_t m_usage GUARDED_BY(m_mutex){0};
+
+public:
+    explicit RecentSyncBlocks(size_t max_usage) : m_max_usage{max_usage} {}
+
+    SyncBlock Get(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void Put(const uint256& hash, const SyncBlock& entry) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    size_t Size() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) { return WITH_LOCK(m_mutex, return m_blocks.size()); }
+    size_t DynamicMemoryUsage() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) { return WITH_LOCK(m_mutex, return m_usage); }
+};
+
+/**
+ * Return the block cache shared by all index syncs in progress, creating it if
+ * there is none. The cache is released once the last sync holding it finishes.
+ */
+std::shared_ptr<RecentSyncBlocks> GetRecentSyncBlocks();
+
+/**
+ * Reads blocks on a separate thread ahead of an index sync loop, following the
+ * active chain from the last requested block, so that disk reads and
+ * deserialization overlap with CustomAppend. If a prepare function is given,
+ * it is run for each block on a pool of worker threads before the block is
+ * handed to the sync loop.
+ */
+class BlockReadAhead
+{
+public:
+    using PrepareFn = std::function<void(const interfaces::BlockInfo&)>;
+
+    /**
+     * @param[in] chain    Chain to follow; read under cs_main.
+     * @param[in] prepare  Optional function run for each block before it is returned by Get().
+     * @param[in] cache    Cache shared with other syncs, or nullptr.
+     */
+    BlockReadAhead(const node::BlockManager& blockman, const CChain& chain, bool read_undo, PrepareFn prepare,
+                   std::shared_ptr<RecentSyncBlocks> cache, const std::string& index_name);
+    /** Stops and joins all threads. Once this returns, prepare is no longer called. */
+    ~BlockReadAhead();
+
+    /**
+     * Return the data for the given block, waiting for it to be read (and
+     * prepared) if necessary. If the block is not the one that was read ahead,
+     * e.g. after a reorg, reading restarts from it. Returns a null block if it
+     * could not be read.
+     */
+    SyncBlock Get(const CBlockIndex& index) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Slot {
+        const CBlockIndex* const index;
+        const SyncBlock entry;
+        //! Whether a prepare worker has picked up this block.
+        bool preparing{false};
+        //! Whether the block is ready to be returned.
+        bool done{false};
+    };
+
+    const node::BlockManager& m_blockman;
+    const CChain& m_chain;
+    const bool m_read_undo;
+    const PrepareFn m_prepare;
+    const std::shared_ptr<RecentSyncBlocks> m_cache;
+    const std::string m_read_thread_name;
+    const std::string m_prepare_thread_name;
+
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    //! Blocks read so far, in chain order, starting with the next one to be returned.
+    std::deque<std::shared_ptr<Slot>> m_queue GUARDED_BY(m_mutex);
+    //! Next block to read, or nullptr if reading is paused.
+    const CBlockIndex* m_next GUARDED_BY(m_mutex){nullptr};
+    //! Incremented whenever the read position is reset, so that in-flight reads are discarded.
+    uint64_t m_generation GUARDED_BY(m_mutex){0};
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::thread m_thread_read;
+    std::vector<std::thread> m_threads_prepare;
+
+    SyncBlock Read(const CBlockIndex& index) const;
+    void ThreadRead() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void ThreadPrepare() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
+#endif // BITCOIN_INDEX_BLOCKREADAHEAD_H
@@ -25,6 +25,8 @@ struct BlockManagerOpts {
     const CChainParams& chainparams;
     bool use_xor{DEFAULT_XOR_BLOCKSDIR};
     uint64_t prune_target{0};
+    //! Maximum number of block files to prune per flush during automatic pruning (0 = no limit)
+    uint32_t prune_max_files{0};
     bool fast_prune{false};
     const fs::path blocks_dir;
     Notifications& notifications;
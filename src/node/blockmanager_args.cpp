@@ -12,7 +12,9 @@
 #include <util/translation.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 
 namespace node {
 util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Options& opts)
@@ -33,6 +35,13 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Op
     }
     opts.prune_target = nPruneTarget;
 
+    if (auto value{args.GetIntArg("-prunemaxfiles")}) {
+        if (*value < 0) {
+            return util::Error{_("-prunemaxfiles cannot be configured with a negative value.")};
+        }
+        opts.prune_max_files = static_cast<uint32_t>(std::min<int64_t>(*value, std::numeric_limits<uint32_t>::max()));
+    }
+
     if (auto value{args.GetBoolArg("-fastprune")}) opts.fast_prune = *value;
 
     ReadDatabaseArgs(args, opts.block_tree_db_params.options);
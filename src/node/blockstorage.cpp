@@ -16,6 +16,7 @@
 #include <kernel/messagestartchars.h>
 #include <kernel/notifications_interface.h>
 #include <logging.h>
+#include <logging/timer.h>
 #include <pow.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
@@ -33,6 +34,7 @@
 #include <util/fs.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
+#include <util/thread.h>
 #include <util/translation.h>
 #include <validation.h>
 
@@ -307,6 +309,10 @@ void BlockManager::FindFilesToPrune(
     ChainstateManager& chainman)
 {
     LOCK2(cs_main, cs_LastBlockFile);
+    if (NodeClock::now() < m_prune_continue_time) {
+        m_check_for_pruning = true;
+        return;
+    }
     // Distribute our -prune budget over all chainstates.
     const auto target = std::max(
         MIN_DISK_SPACE_FOR_BLOCK_FILES, GetPruneTarget() / chainman.GetAll().size());
@@ -327,7 +333,7 @@ void BlockManager::FindFilesToPrune(
     // before the next pruning.
     uint64_t nBuffer = BLOCKFILE_CHUNK_SIZE + UNDOFILE_CHUNK_SIZE;
     uint64_t nBytesToPrune;
-    int count = 0;
+    uint32_t count{0};
 
     if (nCurrentUsage + nBuffer >= target) {
         // On a prune event, the chainstate DB is flushed.
@@ -360,6 +366,13 @@ void BlockManager::FindFilesToPrune(
                 continue;
             }
 
+            if (m_opts.prune_max_files > 0 && count >= m_opts.prune_max_files) {
+                // Leave the rest for a later flush.
+                m_check_for_pruning = true;
+                m_prune_continue_time = NodeClock::now() + PRUNE_CONTINUE_INTERVAL;
+                break;
+            }
+
             PruneOneBlockFile(fileNumber);
             // Queue up the files for removal
             setFilesToPrune.insert(fileNumber);
@@ -787,6 +800,37 @@ void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
     }
 }
 
+void BlockManager::ScheduleUnlinkPrunedFiles(const std::set<int>& setFilesToPrune)
+{
+    if (setFilesToPrune.empty()) return;
+    {
+        LOCK(m_unlink_mutex);
+        m_files_to_unlink.insert(setFilesToPrune.begin(), setFilesToPrune.end());
+        if (!m_unlink_thread.joinable()) {
+            m_unlink_thread = std::thread(&util::TraceThread, "prune", [this] { ThreadUnlinkPrunedFiles(); });
+        }
+    }
+    m_unlink_cv.notify_one();
+}
+
+void BlockManager::ThreadUnlinkPrunedFiles()
+{
+    while (true) {
+        std::set<int> files;
+        {
+            WAIT_LOCK(m_unlink_mutex, lock);
+            while (!m_unlink_stop && m_files_to_unlink.empty()) {
+                m_unlink_cv.wait(lock);
+            }
+            // Finish any remaining work before stopping.
+            if (m_files_to_unlink.empty()) return;
+            files.swap(m_files_to_unlink);
+        }
+        LOG_TIME_MILLIS_WITH_CATEGORY("unlink pruned files", BCLog::BENCH);
+        UnlinkPrunedFiles(files);
+    }
+}
+
 AutoFile BlockManager::OpenBlockFile(const FlatFilePos& pos, bool fReadOnly) const
 {
     return AutoFile{m_block_file_seq.Open(pos, fReadOnly), m_xor_key};
@@ -1184,6 +1228,13 @@ BlockManager::BlockManager(const util::SignalInterrupt& interrupt, Options opts)
     }
 }
 
+BlockManager::~BlockManager()
+{
+    WITH_LOCK(m_unlink_mutex, m_unlink_stop = true);
+    m_unlink_cv.notify_all();
+    if (m_unlink_thread.joinable()) m_unlink_thread.join();
+}
+
 class ImportingNow
 {
     std::atomic<bool>& m_importing;
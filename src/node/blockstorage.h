@@ -19,9 +19,11 @@
 #include <uint256.h>
 #include <util/fs.h>
 #include <util/hasher.h>
+#include <util/time.h>
 
 #include <array>
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -31,6 +33,7 @@
 #include <set>
 #include <span>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -73,6 +76,8 @@ static const unsigned int BLOCKFILE_CHUNK_SIZE = 0x1000000; // 16 MiB
 static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
 /** The maximum size of a blk?????.dat file (since 0.8) */
 static const unsigned int MAX_BLOCKFILE_SIZE = 0x8000000; // 128 MiB
+/** Minimum time before continuing an automatic prune that was cut short by -prunemaxfiles */
+static constexpr std::chrono::minutes PRUNE_CONTINUE_INTERVAL{1};
 
 /** Size of header written by WriteBlock before a serialized CBlock (8 bytes) */
 static constexpr size_t BLOCK_SERIALIZATION_HEADER_SIZE{std::tuple_size_v<MessageStartChars> + sizeof(unsigned int)};
@@ -192,6 +197,10 @@ private:
      * The block index is updated by unsetting HAVE_DATA and HAVE_UNDO for any blocks that were stored in the deleted files.
      * A db flag records the fact that at least some block files have been pruned.
      *
+     * If -prunemaxfiles limits the number of files pruned at once and more files need pruning to reach
+     * the target, m_check_for_pruning is left set so that a later flush continues pruning, but not before
+     * PRUNE_CONTINUE_INTERVAL has passed. Otherwise every flush would prune and force a full chainstate flush.
+     *
      * @param[out]   setFilesToPrune   The set of file indices that can be unlinked will be returned
      * @param        last_prune        The last height we're able to prune, according to the prune locks
      */
@@ -233,6 +242,9 @@ private:
      */
     bool m_check_for_pruning = false;
 
+    /** Earliest time at which a prune cut short by -prunemaxfiles may continue */
+    NodeClock::time_point m_prune_continue_time GUARDED_BY(::cs_main){};
+
     const bool m_prune_mode;
 
     const std::vector<std::byte> m_xor_key;
@@ -258,10 +270,21 @@ private:
     const FlatFileSeq m_block_file_seq;
     const FlatFileSeq m_undo_file_seq;
 
+    Mutex m_unlink_mutex;
+    std::condition_variable m_unlink_cv;
+    /** Pruned block files whose blk/rev files still need to be removed by m_unlink_thread. */
+    std::set<int> m_files_to_unlink GUARDED_BY(m_unlink_mutex);
+    bool m_unlink_stop GUARDED_BY(m_unlink_mutex){false};
+    std::thread m_unlink_thread;
+
+    void ThreadUnlinkPrunedFiles() EXCLUSIVE_LOCKS_REQUIRED(!m_unlink_mutex);
+
 public:
     using Options = kernel::BlockManagerOpts;
 
     explicit BlockManager(const util::SignalInterrupt& interrupt, Options opts);
+    /** Waits for any scheduled removal of pruned files to finish. */
+    ~BlockManager();
 
     const util::SignalInterrupt& m_interrupt;
     std::atomic<bool> m_importing{false};
@@ -413,6 +436,14 @@ public:
      */
     void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
 
+    /**
+     * Unlink the specified files on a background thread. The files must already
+     * be pruned in the block index, and the block index written to disk, so that
+     * nothing refers to them anymore. This keeps slow storage from stalling
+     * validation while cs_main is held.
+     */
+    void ScheduleUnlinkPrunedFiles(const std::set<int>& setFilesToPrune) EXCLUSIVE_LOCKS_REQUIRED(!m_unlink_mutex);
+
     /** Functions for disk access for blocks */
     bool ReadBlock(CBlock& block, const FlatFilePos& pos) const;
     bool ReadBlock(CBlock& block, const CBlockIndex& index) const;
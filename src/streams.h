@@ -12,9 +12,11 @@
 #include <util/overflow.h>
 
 #include <algorithm>
+#include <array>
 #include <assert.h>
 #include <cstddef>
 #include <cstdio>
+#include <cstring>
 #include <ios>
 #include <limits>
 #include <optional>
@@ -32,6 +34,34 @@ inline void Xor(Span<std::byte> write, Span<const std::byte> key, size_t key_off
     }
     key_offset %= key.size();
 
+    if (key.size() == sizeof(uint64_t)) {
+        // Block files and LevelDB values are obfuscated with 8-byte keys, so
+        // this acts on every byte read from or written to them. Rotate the key
+        // to line up with the start of `write` and apply it a word at a time,
+        // which compilers turn into vector instructions.
+        std::array<std::byte, sizeof(uint64_t)> rotated;
+        for (size_t i = 0; i < rotated.size(); ++i) {
+            rotated[i] = key[(key_offset + i) % key.size()];
+        }
+        uint64_t key_word;
+        std::memcpy(&key_word, rotated.data(), sizeof(key_word));
+
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= write.size(); i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, write.data() + i, sizeof(word));
+            word ^= key_word;
+            std::memcpy(write.data() + i, &word, sizeof(word));
+        }
+        if (i != write.size()) {
+            uint64_t word{0};
+            std::memcpy(&word, write.data() + i, write.size() - i);
+            word ^= key_word;
+            std::memcpy(write.data() + i, &word, write.size() - i);
+        }
+        return;
+    }
+
     for (size_t i = 0, j = key_offset; i != write.size(); i++) {
         write[i] ^= key[j++];
 
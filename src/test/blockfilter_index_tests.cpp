@@ -271,6 +271,60 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync, BuildChainTestingSetup)
     filter_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_prepared_filters, BuildChainTestingSetup)
+{
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    const CScript coinbase_script_pub_key{GetScriptForDestination(PKHash(GenerateRandomKey().GetPubKey()))};
+    const auto replace_blocks{[&](int height, int count) {
+        CBlockIndex* block_index{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain()[height])};
+        BlockValidationState state;
+        BOOST_REQUIRE(chainstate.InvalidateBlock(state, block_index));
+        for (int i = 0; i < count; ++i) CreateAndProcessBlock({}, coinbase_script_pub_key);
+    }};
+
+    // This index is synced before the blocks are connected, so it appends
+    // them from notifications and never prepares filters for them.
+    replace_blocks(1, 0);
+    BlockFilterIndex live_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true);
+    BOOST_REQUIRE(live_index.Init());
+    BOOST_REQUIRE(live_index.StartBackgroundSync());
+    IndexWaitSynced(live_index, *Assert(m_node.shutdown_signal));
+    for (int i = 0; i < 20; ++i) CreateAndProcessBlock({}, coinbase_script_pub_key);
+    BOOST_REQUIRE(live_index.BlockUntilSyncedToCurrentChain());
+
+    // This one syncs with prepared filters, then again across a rewind.
+    {
+        BlockFilterIndex sync_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, false, true);
+        BOOST_REQUIRE(sync_index.Init());
+        BOOST_REQUIRE(sync_index.StartBackgroundSync());
+        IndexWaitSynced(sync_index, *Assert(m_node.shutdown_signal));
+        sync_index.Stop();
+    }
+    replace_blocks(15, 10);
+    BOOST_REQUIRE(live_index.BlockUntilSyncedToCurrentChain());
+    BlockFilterIndex sync_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, false, false);
+    BOOST_REQUIRE(sync_index.Init());
+    BOOST_REQUIRE(sync_index.StartBackgroundSync());
+    IndexWaitSynced(sync_index, *Assert(m_node.shutdown_signal));
+
+    {
+        LOCK(cs_main);
+        BOOST_CHECK_EQUAL(m_node.chainman->ActiveChain().Height(), 24);
+        uint256 live_last_header, sync_last_header;
+        for (const CBlockIndex* block_index = m_node.chainman->ActiveChain().Genesis();
+             block_index != nullptr;
+             block_index = m_node.chainman->ActiveChain().Next(block_index)) {
+            CheckFilterLookups(live_index, block_index, live_last_header, m_node.chainman->m_blockman);
+            CheckFilterLookups(sync_index, block_index, sync_last_header, m_node.chainman->m_blockman);
+            BOOST_CHECK_EQUAL(live_last_header, sync_last_header);
+        }
+    }
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    live_index.Stop();
+    sync_index.Stop();
+}
+
 BOOST_FIXTURE_TEST_CASE(blockfilter_index_init_destroy, BasicTestingSetup)
 {
     BlockFilterIndex* filter_index;
@@ -12,6 +12,7 @@
 #include <streams.h>
 #include <undo.h>
 #include <univalue.h>
+#include <util/golombrice.h>
 #include <util/strencodings.h>
 
 #include <boost/test/unit_test.hpp>
@@ -54,6 +55,40 @@ BOOST_AUTO_TEST_CASE(gcsfilter_default_constructor)
     BOOST_CHECK_EQUAL(params.m_M, 1U);
 }
 
+BOOST_FIXTURE_TEST_CASE(golombrice_reader_test, BasicTestingSetup)
+{
+    // Compare GolombRiceReader against the bit-by-bit BitStreamReader decoder,
+    // including quotients longer than a 64-bit word.
+    for (uint8_t P : {0, 1, 7, 19, 20, 32}) {
+        std::vector<uint64_t> values;
+        for (int i = 0; i < 200; ++i) {
+            const uint64_t remainder{m_rng.randbits(P)};
+            const uint64_t quotient{i % 50 == 0 ? 64 + m_rng.randrange(200) : m_rng.randrange(4)};
+            values.push_back((quotient << P) + remainder);
+        }
+
+        std::vector<unsigned char> encoded;
+        {
+            VectorWriter stream{encoded, 0};
+            BitStreamWriter bitwriter{stream};
+            for (uint64_t value : values) {
+                GolombRiceEncode(bitwriter, P, value);
+            }
+            bitwriter.Write(0x123456789abcdef0, 64);
+        }
+
+        SpanReader stream{encoded};
+        BitStreamReader bitreader{stream};
+        GolombRiceReader reader{encoded};
+        for (uint64_t value : values) {
+            BOOST_CHECK_EQUAL(GolombRiceDecode(bitreader, P), value);
+            BOOST_CHECK_EQUAL(reader.Decode(P), value);
+        }
+        BOOST_CHECK_EQUAL(reader.Read(64), 0x123456789abcdef0U);
+        BOOST_CHECK_THROW(reader.Read(8), std::ios_base::failure);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(blockfilter_basic_test)
 {
     CScript included_scripts[5], excluded_scripts[4];
@@ -5,18 +5,25 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <clientversion.h>
+#include <common/args.h>
+#include <node/blockmanager_args.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
 #include <script/solver.h>
 #include <primitives/block.h>
 #include <util/chaintype.h>
+#include <util/time.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
 #include <test/util/logging.h>
 #include <test/util/setup_common.h>
 
+#include <optional>
+#include <string>
+#include <vector>
+
 using node::BLOCK_SERIALIZATION_HEADER_SIZE;
 using node::BlockManager;
 using node::KernelNotifications;
@@ -57,6 +64,31 @@ BOOST_AUTO_TEST_CASE(blockmanager_find_block_pos)
     BOOST_CHECK_EQUAL(actual.nPos, BLOCK_SERIALIZATION_HEADER_SIZE + ::GetSerializeSize(TX_WITH_WITNESS(params->GenesisBlock())) + BLOCK_SERIALIZATION_HEADER_SIZE);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_schedule_unlink_pruned_files)
+{
+    const auto params {CreateChainParams(ArgsManager{}, ChainType::MAIN)};
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    const BlockManager::Options blockman_opts{
+        .chainparams = *params,
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    const fs::path block_file{m_args.GetBlocksDirPath() / "blk00000.dat"};
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        BOOST_CHECK(!blockman.WriteBlock(params->GenesisBlock(), 0).IsNull());
+        BOOST_CHECK(fs::exists(block_file));
+
+        // Removal happens in the background; the destructor waits for it.
+        blockman.ScheduleUnlinkPrunedFiles({0});
+    }
+    BOOST_CHECK(!fs::exists(block_file));
+}
+
 BOOST_FIXTURE_TEST_CASE(blockmanager_scan_unlink_already_pruned_files, TestChain100Setup)
 {
     // Cap last block file size, and mine new block in a new block file.
@@ -98,6 +130,86 @@ BOOST_FIXTURE_TEST_CASE(blockmanager_scan_unlink_already_pruned_files, TestChain
     BOOST_CHECK(!blockman.OpenBlockFile(new_pos, true).IsNull());
 }
 
+struct PruneMaxFilesTestingSetup : public TestChain100Setup {
+    PruneMaxFilesTestingSetup()
+        : TestChain100Setup{ChainType::REGTEST, {.extra_args = {"-prune=550", "-prunemaxfiles=1", "-fastprune"}}} {}
+};
+
+BOOST_FIXTURE_TEST_CASE(blockmanager_prune_max_files, PruneMaxFilesTestingSetup)
+{
+    const auto& chainman = Assert(m_node.chainman);
+    auto& blockman = chainman->m_blockman;
+    Chainstate& chainstate = chainman->ActiveChainstate();
+    BOOST_REQUIRE(blockman.IsPruneMode());
+
+    // Give the next few blocks a file each, then bury them deep enough to be
+    // prunable. Files 0 to 6 end up prunable, file 7 holds the recent blocks.
+    constexpr int num_old_files{7};
+    for (int i = 0; i < num_old_files; ++i) {
+        WITH_LOCK(chainman->GetMutex(), blockman.GetBlockFileInfo(chainman->ActiveChain().Tip()->GetBlockPos().nFile)->nSize = 0x10000);
+        mineBlocks(1);
+    }
+    mineBlocks(MIN_BLOCKS_TO_KEEP);
+
+    // Make the old files count as full, which puts usage (896 MiB) three
+    // files over the 550 MiB target.
+    for (int file = 0; file < num_old_files; ++file) {
+        blockman.GetBlockFileInfo(file)->nSize = MAX_BLOCKFILE_SIZE;
+    }
+    const auto is_pruned{[&](int file) { return blockman.GetBlockFileInfo(file)->nSize == 0; }};
+    const auto num_pruned{[&] {
+        int count{0};
+        for (int file = 0; file < num_old_files; ++file) count += is_pruned(file);
+        return count;
+    }};
+    BlockValidationState state;
+
+    // Only one file is pruned per flush.
+    chainstate.PruneAndFlush();
+    BOOST_CHECK(is_pruned(0));
+    BOOST_CHECK_EQUAL(num_pruned(), 1);
+
+    // Pruning continues on a later flush, but not right away.
+    BOOST_CHECK(chainstate.FlushStateToDisk(state, FlushStateMode::IF_NEEDED));
+    BOOST_CHECK_EQUAL(num_pruned(), 1);
+    SetMockTime(GetMockTime() + node::PRUNE_CONTINUE_INTERVAL);
+    BOOST_CHECK(chainstate.FlushStateToDisk(state, FlushStateMode::IF_NEEDED));
+    BOOST_CHECK(is_pruned(1));
+    BOOST_CHECK_EQUAL(num_pruned(), 2);
+
+    // Repeated flushes converge on the target and then stop pruning.
+    for (int i = 0; i < num_old_files; ++i) {
+        SetMockTime(GetMockTime() + node::PRUNE_CONTINUE_INTERVAL);
+        BOOST_CHECK(chainstate.FlushStateToDisk(state, FlushStateMode::IF_NEEDED));
+    }
+    BOOST_CHECK_EQUAL(num_pruned(), 3);
+    BOOST_CHECK_LT(blockman.CalculateCurrentUsage() + node::BLOCKFILE_CHUNK_SIZE + node::UNDOFILE_CHUNK_SIZE, blockman.GetPruneTarget());
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_prune_max_files_args)
+{
+    const auto params{CreateChainParams(ArgsManager{}, ChainType::REGTEST)};
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    const auto apply{[&](std::vector<const char*> args) -> std::optional<uint32_t> {
+        args.insert(args.begin(), "ignored");
+        ArgsManager argsman;
+        argsman.AddArg("-prunemaxfiles", "", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+        std::string error;
+        BOOST_REQUIRE(argsman.ParseParameters(args.size(), args.data(), error));
+        BlockManager::Options opts{
+            .chainparams = *params,
+            .blocks_dir = {},
+            .notifications = notifications,
+            .block_tree_db_params = {.path = {}, .cache_bytes = 0},
+        };
+        if (!node::ApplyArgsManOptions(argsman, opts)) return std::nullopt;
+        return opts.prune_max_files;
+    }};
+    BOOST_CHECK_EQUAL(apply({}).value(), 0U);
+    BOOST_CHECK_EQUAL(apply({"-prunemaxfiles=3"}).value(), 3U);
+    BOOST_CHECK(!apply({"-prunemaxfiles=-1"}));
+}
+
 BOOST_FIXTURE_TEST_CASE(blockmanager_block_data_availability, TestChain100Setup)
 {
     // The goal of the function is to return the first not pruned block in the range [upper_block, lower_block].
@@ -0,0 +1,290 @@
+// Copyright (c) 2026 The BTC-Prometheus developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <blockfilter.h>
+#include <chain.h>
+#include <consensus/amount.h>
+#include <consensus/validation.h>
+#include <core_memusage.h>
+#include <index/blockfilterindex.h>
+#include <index/blockreadahead.h>
+#include <index/coinstatsindex.h>
+#include <index/txindex.h>
+#include <interfaces/chain.h>
+#include <kernel/coinstats.h>
+#include <primitives/block.h>
+#include <test/util/blockfilter.h>
+#include <test/util/index.h>
+#include <test/util/setup_common.h>
+#include <undo.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <optional>
+#include <set>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(blockreadahead_tests)
+
+static std::vector<const CBlockIndex*> ActiveChainBlocks(ChainstateManager& chainman)
+{
+    LOCK(cs_main);
+    std::vector<const CBlockIndex*> blocks;
+    for (const CBlockIndex* index = chainman.ActiveChain().Genesis(); index; index = chainman.ActiveChain().Next(index)) {
+        blocks.push_back(index);
+    }
+    return blocks;
+}
+
+//! Check that the filter index matches filters computed directly from disk for the active chain.
+static void CheckFilters(BlockFilterIndex& filter_index, ChainstateManager& chainman)
+{
+    uint256 last_header;
+    for (const CBlockIndex* index : ActiveChainBlocks(chainman)) {
+        BlockFilter expected_filter;
+        BOOST_REQUIRE(ComputeFilter(filter_index.GetFilterType(), *index, expected_filter, chainman.m_blockman));
+        BlockFilter filter;
+        uint256 filter_header;
+        BOOST_REQUIRE(filter_index.LookupFilter(index, filter));
+        BOOST_REQUIRE(filter_index.LookupFilterHeader(index, filter_header));
+        BOOST_CHECK_EQUAL(filter.GetHash(), expected_filter.GetHash());
+        BOOST_CHECK_EQUAL(filter_header, expected_filter.ComputeHeader(last_header));
+        last_header = filter_header;
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(blockreadahead_follows_chain, TestChain100Setup)
+{
+    const auto blocks{ActiveChainBlocks(*m_node.chainman)};
+    BlockReadAhead read_ahead{m_node.chainman->m_blockman, m_node.chainman->ActiveChain(), /*read_undo=*/true, {}, nullptr, "test"};
+    for (const CBlockIndex* index : blocks) {
+        const SyncBlock entry{read_ahead.Get(*index)};
+        BOOST_REQUIRE(entry.block);
+        BOOST_CHECK_EQUAL(entry.block->GetHash(), index->GetBlockHash());
+        BOOST_CHECK_EQUAL(bool{entry.undo}, index->nHeight > 0);
+    }
+
+    // Going back, e.g. after a reorg, restarts reading from the requested block.
+    for (const int height : {50, 10, 11, 12, 99, 0}) {
+        const SyncBlock entry{read_ahead.Get(*blocks.at(height))};
+        BOOST_REQUIRE(entry.block);
+        BOOST_CHECK_EQUAL(entry.block->GetHash(), blocks.at(height)->GetBlockHash());
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(blockreadahead_read_failure, TestChain100Setup)
+{
+    const auto blocks{ActiveChainBlocks(*m_node.chainman)};
+    CBlockIndex* missing{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain()[50])};
+    WITH_LOCK(cs_main, missing->nStatus &= ~BLOCK_HAVE_DATA);
+
+    BlockReadAhead read_ahead{m_node.chainman->m_blockman, m_node.chainman->ActiveChain(), /*read_undo=*/false, {}, nullptr, "test"};
+    for (int height = 40; height < 50; ++height) {
+        BOOST_REQUIRE(read_ahead.Get(*blocks.at(height)).block);
+    }
+    BOOST_CHECK(!read_ahead.Get(*missing).block);
+    // Nothing past the failed block is returned.
+    BOOST_CHECK(!read_ahead.Get(*missing).block);
+
+    // Once the block can be read again, reading resumes from it.
+    WITH_LOCK(cs_main, missing->nStatus |= BLOCK_HAVE_DATA);
+    for (int height = 50; height < 60; ++height) {
+        const SyncBlock entry{read_ahead.Get(*blocks.at(height))};
+        BOOST_REQUIRE(entry.block);
+        BOOST_CHECK_EQUAL(entry.block->GetHash(), blocks.at(height)->GetBlockHash());
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(blockreadahead_prepare, TestChain100Setup)
+{
+    const auto blocks{ActiveChainBlocks(*m_node.chainman)};
+    Mutex mutex;
+    std::set<uint256> prepared;
+    BlockReadAhead read_ahead{m_node.chainman->m_blockman, m_node.chainman->ActiveChain(), /*read_undo=*/true,
+                              [&](const interfaces::BlockInfo& block) {
+                                  BOOST_CHECK(block.data);
+                                  BOOST_CHECK_EQUAL(bool{block.undo_data}, block.height > 0);
+                                  WITH_LOCK(mutex, prepared.insert(block.hash));
+                              },
+                              nullptr, "test"};
+    for (const CBlockIndex* index : blocks) {
+        BOOST_REQUIRE(read_ahead.Get(*index).block);
+        BOOST_CHECK(WITH_LOCK(mutex, return prepared.contains(index->GetBlockHash())));
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(recent_sync_blocks_budget, TestChain100Setup)
+{
+    const auto blocks{ActiveChainBlocks(*m_node.chainman)};
+    std::vector<SyncBlock> entries;
+    for (int height = 1; height <= 10; ++height) {
+        auto block{std::make_shared<CBlock>()};
+        BOOST_REQUIRE(m_node.chainman->m_blockman.ReadBlock(*block, *blocks.at(height)));
+        entries.push_back({std::move(block), nullptr});
+    }
+    const size_t usage{RecursiveDynamicUsage(*entries.back().block)};
+
+    RecentSyncBlocks cache{3 * usage + usage / 2};
+    for (int i = 0; i < 10; ++i) {
+        cache.Put(entries[i].block->GetHash(), entries[i]);
+        BOOST_CHECK(cache.DynamicMemoryUsage() <= 3 * usage + usage / 2);
+    }
+    BOOST_CHECK_EQUAL(cache.Size(), 3U);
+    BOOST_CHECK(!cache.Get(entries[6].block->GetHash()).block);
+    BOOST_CHECK(cache.Get(entries[9].block->GetHash()).block);
+
+    // Undo data is merged into an existing entry.
+    auto undo{std::make_shared<CBlockUndo>()};
+    BOOST_REQUIRE(m_node.chainman->m_blockman.ReadBlockUndo(*undo, *blocks.at(10)));
+    cache.Put(entries[9].block->GetHash(), {entries[9].block, undo});
+    BOOST_CHECK(cache.Get(entries[9].block->GetHash()).undo);
+
+    // The newest entry is kept even if it exceeds the budget by itself.
+    RecentSyncBlocks tiny{1};
+    tiny.Put(entries[0].block->GetHash(), entries[0]);
+    tiny.Put(entries[1].block->GetHash(), entries[1]);
+    BOOST_CHECK_EQUAL(tiny.Size(), 1U);
+    BOOST_CHECK(tiny.Get(entries[1].block->GetHash()).block);
+
+    // The shared cache only lives as long as someone holds it.
+    auto shared{GetRecentSyncBlocks()};
+    BOOST_CHECK_EQUAL(GetRecentSyncBlocks(), shared);
+    shared->Put(entries[0].block->GetHash(), entries[0]);
+    shared.reset();
+    BOOST_CHECK_EQUAL(GetRecentSyncBlocks()->Size(), 0U);
+}
+
+BOOST_FIXTURE_TEST_CASE(index_sync_across_reorg, TestChain100Setup)
+{
+    {
+        BlockFilterIndex filter_index{interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, /*f_memory=*/false, /*f_wipe=*/true};
+        BOOST_REQUIRE(filter_index.Init());
+        BOOST_REQUIRE(filter_index.StartBackgroundSync());
+        IndexWaitSynced(filter_index, *Assert(m_node.shutdown_signal));
+        filter_index.Stop();
+    }
+
+    // While the index is stopped, replace the last ten blocks with a longer fork.
+    {
+        CBlockIndex* fork_point{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain()[91])};
+        BlockValidationState state;
+        BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, fork_point));
+        const CScript script_pub_key{GetScriptForDestination(PKHash(GenerateRandomKey().GetPubKey()))};
+        for (int i = 0; i < 15; ++i) {
+            CreateAndProcessBlock({}, script_pub_key);
+        }
+        BOOST_REQUIRE_EQUAL(WITH_LOCK(cs_main, return m_node.chainman->ActiveHeight()), 105);
+    }
+
+    // The index rewinds the stale blocks and syncs the fork.
+    BlockFilterIndex filter_index{interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, /*f_memory=*/false, /*f_wipe=*/false};
+    BOOST_REQUIRE(filter_index.Init());
+    BOOST_REQUIRE(filter_index.StartBackgroundSync());
+    IndexWaitSynced(filter_index, *Assert(m_node.shutdown_signal));
+    CheckFilters(filter_index, *m_node.chainman);
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    filter_index.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(index_sync_read_failure, TestChain100Setup)
+{
+    const auto blocks{ActiveChainBlocks(*m_node.chainman)};
+    CBlockIndex* missing{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain()[50])};
+    WITH_LOCK(cs_main, missing->nStatus &= ~BLOCK_HAVE_DATA);
+    {
+        BlockFilterIndex filter_index{interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, /*f_memory=*/true};
+        BOOST_REQUIRE(filter_index.Init());
+        BOOST_REQUIRE(filter_index.StartBackgroundSync());
+        // The index aborts the node instead of skipping the block.
+        while (!*Assert(m_node.shutdown_signal)) UninterruptibleSleep(10ms);
+        filter_index.Stop();
+
+        BlockFilter filter;
+        BOOST_CHECK(filter_index.LookupFilter(blocks.at(49), filter));
+        BOOST_CHECK(!filter_index.LookupFilter(blocks.at(50), filter));
+    }
+    WITH_LOCK(cs_main, missing->nStatus |= BLOCK_HAVE_DATA);
+    BOOST_REQUIRE(m_node.shutdown_signal->reset());
+    m_node.exit_status = EXIT_SUCCESS;
+
+    BlockFilterIndex filter_index{interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, /*f_memory=*/true};
+    BOOST_REQUIRE(filter_index.Init());
+    BOOST_REQUIRE(filter_index.StartBackgroundSync());
+    IndexWaitSynced(filter_index, *Assert(m_node.shutdown_signal));
+    CheckFilters(filter_index, *m_node.chainman);
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    filter_index.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(concurrent_index_sync, TestChain100Setup)
+{
+    // Spend a coinbase output so that coinstatsindex depends on undo data.
+    const CScript script_pub_key{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], 0, 1, coinbaseKey, script_pub_key, 49 * COIN, /*submit=*/false)};
+    CreateAndProcessBlock({spend}, script_pub_key);
+    const auto blocks{ActiveChainBlocks(*m_node.chainman)};
+
+    std::vector<std::optional<kernel::CCoinsStats>> serial_stats;
+    std::vector<uint256> serial_tx_blocks;
+    const auto lookup_txs{[&](TxIndex& txindex) {
+        std::vector<uint256> tx_blocks;
+        for (const CBlockIndex* index : blocks) {
+            CBlock block;
+            BOOST_REQUIRE(m_node.chainman->m_blockman.ReadBlock(block, *index));
+            for (const auto& tx : block.vtx) {
+                uint256 block_hash;
+                CTransactionRef tx_disk;
+                tx_blocks.push_back(txindex.FindTx(tx->GetHash(), block_hash, tx_disk) ? block_hash : uint256::ZERO);
+            }
+        }
+        return tx_blocks;
+    }};
+    {
+        TxIndex txindex{interfaces::MakeChain(m_node), 1 << 20, true};
+        BOOST_REQUIRE(txindex.Init());
+        BOOST_REQUIRE(txindex.StartBackgroundSync());
+        IndexWaitSynced(txindex, *Assert(m_node.shutdown_signal));
+        serial_tx_blocks = lookup_txs(txindex);
+        txindex.Stop();
+    }
+    {
+        CoinStatsIndex coin_stats_index{interfaces::MakeChain(m_node), 1 << 20, true};
+        BOOST_REQUIRE(coin_stats_index.Init());
+        BOOST_REQUIRE(coin_stats_index.StartBackgroundSync());
+        IndexWaitSynced(coin_stats_index, *Assert(m_node.shutdown_signal));
+        for (const CBlockIndex* index : blocks) serial_stats.push_back(coin_stats_index.LookUpStats(*index));
+        coin_stats_index.Stop();
+    }
+
+    TxIndex txindex{interfaces::MakeChain(m_node), 1 << 20, true};
+    CoinStatsIndex coin_stats_index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(txindex.Init());
+    BOOST_REQUIRE(coin_stats_index.Init());
+    BOOST_REQUIRE(txindex.StartBackgroundSync());
+    BOOST_REQUIRE(coin_stats_index.StartBackgroundSync());
+    IndexWaitSynced(txindex, *Assert(m_node.shutdown_signal));
+    IndexWaitSynced(coin_stats_index, *Assert(m_node.shutdown_signal));
+
+    BOOST_CHECK(lookup_txs(txindex) == serial_tx_blocks);
+    BOOST_CHECK(serial_tx_blocks.back() == blocks.back()->GetBlockHash());
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const auto stats{coin_stats_index.LookUpStats(*blocks[i])};
+        BOOST_REQUIRE(stats && serial_stats[i]);
+        BOOST_CHECK_EQUAL(stats->hashSerialized, serial_stats[i]->hashSerialized);
+        BOOST_CHECK_EQUAL(stats->nTransactionOutputs, serial_stats[i]->nTransactionOutputs);
+        BOOST_CHECK_EQUAL(stats->total_prevout_spent_amount, serial_stats[i]->total_prevout_spent_amount);
+        BOOST_CHECK(stats->total_amount == serial_stats[i]->total_amount);
+    }
+    BOOST_CHECK_EQUAL(serial_stats.back()->total_prevout_spent_amount, 50 * COIN);
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    txindex.Stop();
+    coin_stats_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,7 @@
 #include <cassert>
 #include <cstdint>
 #include <iosfwd>
+#include <optional>
 #include <unordered_set>
 #include <vector>
 
@@ -80,6 +81,15 @@ FUZZ_TARGET(golomb_rice)
 
     assert(encoded_deltas == decoded_deltas);
 
+    {
+        SpanReader stream{golomb_rice_data};
+        const uint32_t n = static_cast<uint32_t>(ReadCompactSize(stream));
+        GolombRiceReader reader{Span{golomb_rice_data}.last(stream.size())};
+        for (uint32_t i = 0; i < n; ++i) {
+            assert(reader.Decode(BASIC_FILTER_P) == decoded_deltas[i]);
+        }
+    }
+
     {
         const std::vector<uint8_t> random_bytes = ConsumeRandomLengthByteVector(fuzzed_data_provider, 1024);
         SpanReader stream{random_bytes};
@@ -89,12 +99,21 @@ FUZZ_TARGET(golomb_rice)
         } catch (const std::ios_base::failure&) {
             return;
         }
+        GolombRiceReader reader{Span{random_bytes}.last(stream.size())};
         BitStreamReader bitreader{stream};
         for (uint32_t i = 0; i < std::min<uint32_t>(n, 1024); ++i) {
+            std::optional<uint64_t> expected;
+            try {
+                expected = GolombRiceDecode(bitreader, BASIC_FILTER_P);
+            } catch (const std::ios_base::failure&) {
+            }
+            std::optional<uint64_t> decoded;
             try {
-                (void)GolombRiceDecode(bitreader, BASIC_FILTER_P);
+                decoded = reader.Decode(BASIC_FILTER_P);
             } catch (const std::ios_base::failure&) {
             }
+            assert(decoded == expected);
+            if (!expected) break;
         }
     }
 }
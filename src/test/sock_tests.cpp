@@ -140,6 +140,59 @@ BOOST_AUTO_TEST_CASE(wait)
     waiter.join();
 }
 
+BOOST_AUTO_TEST_CASE(wait_many)
+{
+    // Sockets stay registered between WaitMany() calls where epoll(7) is
+    // used, so check readiness as the requested events and the set change.
+    int s[2];
+    CreateSocketPair(s);
+    auto a0{std::make_shared<const Sock>(s[0])};
+    auto a1{std::make_shared<const Sock>(s[1])};
+    CreateSocketPair(s);
+    auto b0{std::make_shared<const Sock>(s[0])};
+    auto b1{std::make_shared<const Sock>(s[1])};
+
+    Sock::EventsPerSock events{{a0, Sock::Events{Sock::RECV}}, {b0, Sock::Events{Sock::RECV}}};
+    BOOST_REQUIRE(a0->WaitMany(0ms, events));
+    BOOST_CHECK_EQUAL(events.at(a0).occurred, 0);
+    BOOST_CHECK_EQUAL(events.at(b0).occurred, 0);
+
+    BOOST_REQUIRE_EQUAL(a1->Send("a", 1, 0), 1);
+    BOOST_REQUIRE(a0->WaitMany(24h, events));
+    BOOST_CHECK_EQUAL(events.at(a0).occurred, Sock::RECV);
+    BOOST_CHECK_EQUAL(events.at(b0).occurred, 0);
+
+    // Change the requested events.
+    events.at(a0).requested = 0;
+    events.at(b0).requested = Sock::RECV | Sock::SEND;
+    BOOST_REQUIRE(a0->WaitMany(24h, events));
+    BOOST_CHECK_EQUAL(events.at(a0).occurred, 0);
+    BOOST_CHECK_EQUAL(events.at(b0).occurred, Sock::SEND);
+
+    // Close a socket and let a new one reuse its descriptor number.
+    events.erase(b0);
+    b0.reset();
+    b1.reset();
+    CreateSocketPair(s);
+    auto c0{std::make_shared<const Sock>(s[0])};
+    auto c1{std::make_shared<const Sock>(s[1])};
+    BOOST_REQUIRE_EQUAL(c1->Send("c", 1, 0), 1);
+    events.emplace(c0, Sock::Events{Sock::RECV});
+    events.emplace(c1, Sock::Events{Sock::RECV});
+    events.at(a0).requested = Sock::RECV;
+    BOOST_REQUIRE(a0->WaitMany(24h, events));
+    BOOST_CHECK_EQUAL(events.at(a0).occurred, Sock::RECV);
+    BOOST_CHECK_EQUAL(events.at(c0).occurred, Sock::RECV);
+    BOOST_CHECK_EQUAL(events.at(c1).occurred, 0);
+
+    // A closed peer is reported as readable, like poll(2) does.
+    a1.reset();
+    char buf;
+    BOOST_REQUIRE_EQUAL(a0->Recv(&buf, 1, 0), 1);
+    BOOST_REQUIRE(a0->WaitMany(24h, events));
+    BOOST_CHECK(events.at(a0).occurred & Sock::RECV);
+}
+
 BOOST_AUTO_TEST_CASE(recv_until_terminator_limit)
 {
     constexpr auto timeout = 1min; // High enough so that it is never hit.
@@ -252,6 +252,25 @@ BOOST_AUTO_TEST_CASE(streams_serializedata_xor)
     }
 }
 
+BOOST_AUTO_TEST_CASE(streams_xor_word_key)
+{
+    // The 8-byte key path must match applying the key one byte at a time, for
+    // any offset into the key and any length.
+    const auto key{m_rng.randbytes<std::byte>(8)};
+    for (size_t len : {0, 1, 7, 8, 9, 31, 64, 1000}) {
+        const auto data{m_rng.randbytes<std::byte>(len)};
+        for (size_t offset = 0; offset < 20; ++offset) {
+            auto expected{data};
+            for (size_t i = 0; i < expected.size(); ++i) {
+                expected[i] ^= key[(offset + i) % key.size()];
+            }
+            auto actual{data};
+            util::Xor(actual, key, offset);
+            BOOST_CHECK(actual == expected);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(streams_buffered_file)
 {
     fs::path streams_test_filename = m_args.GetDataDirBase() / "streams_test_tmp";
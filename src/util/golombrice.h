@@ -7,9 +7,15 @@
 
 #include <util/fastrange.h>
 
+#include <crypto/common.h>
+#include <span.h>
 #include <streams.h>
 
+#include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <ios>
+#include <stdexcept>
 
 template <typename OStream>
 void GolombRiceEncode(BitStreamWriter<OStream>& bitwriter, uint8_t P, uint64_t x)
@@ -42,4 +48,95 @@ uint64_t GolombRiceDecode(BitStreamReader<IStream>& bitreader, uint8_t P)
     return (q << P) + r;
 }
 
+/**
+ * Reads a sequence of Golomb-Rice coded values from a byte span. This produces
+ * the same values as repeated GolombRiceDecode calls on a BitStreamReader, but
+ * loads the input 64 bits at a time and decodes the unary-coded quotient with a
+ * single count-leading-ones instead of one bit read per iteration.
+ */
+class GolombRiceReader
+{
+private:
+    Span<const unsigned char> m_data;
+
+    /// Bits loaded from m_data but not consumed yet, most significant bit
+    /// first. Only the top m_bits bits are valid; the rest may hold bits of
+    /// the next input byte, which are loaded again by the next Refill().
+    uint64_t m_buffer{0};
+    int m_bits{0};
+
+    void Refill()
+    {
+        if (m_data.size() >= 8) {
+            m_buffer |= ReadBE64(m_data.data()) >> m_bits;
+            const int bytes{(63 - m_bits) >> 3};
+            m_data = m_data.subspan(bytes);
+            m_bits += bytes * 8;
+        } else {
+            while (m_bits <= 56 && !m_data.empty()) {
+                m_buffer |= uint64_t{m_data[0]} << (56 - m_bits);
+                m_data = m_data.subspan(1);
+                m_bits += 8;
+            }
+        }
+    }
+
+    void Consume(int nbits)
+    {
+        m_buffer = nbits == 64 ? 0 : m_buffer << nbits;
+        m_bits -= nbits;
+    }
+
+    /** Read up to 56 bits. */
+    uint64_t ReadShort(int nbits)
+    {
+        if (m_bits < nbits) {
+            Refill();
+            if (m_bits < nbits) throw std::ios_base::failure("GolombRiceReader: end of data");
+        }
+        if (nbits == 0) return 0;
+        const uint64_t value{m_buffer >> (64 - nbits)};
+        Consume(nbits);
+        return value;
+    }
+
+public:
+    explicit GolombRiceReader(Span<const unsigned char> data) : m_data{data} {}
+
+    /** Read the specified number of bits (at most 64), like BitStreamReader::Read. */
+    uint64_t Read(int nbits)
+    {
+        if (nbits < 0 || nbits > 64) {
+            throw std::out_of_range("nbits must be between 0 and 64");
+        }
+        if (nbits <= 56) return ReadShort(nbits);
+        const uint64_t high{ReadShort(nbits - 32)};
+        return (high << 32) | ReadShort(32);
+    }
+
+    /** Decode one Golomb-Rice coded value with parameter P. */
+    uint64_t Decode(uint8_t P)
+    {
+        // Read unary-encoded quotient: q 1's followed by one 0.
+        uint64_t q{0};
+        while (true) {
+            if (m_bits == 0) {
+                Refill();
+                if (m_bits == 0) throw std::ios_base::failure("GolombRiceReader: end of data");
+            }
+            const int ones{std::min(std::countl_one(m_buffer), m_bits)};
+            q += ones;
+            if (ones < m_bits) {
+                Consume(ones + 1);
+                break;
+            }
+            Consume(ones);
+        }
+
+        const uint64_t r{Read(P)};
+
+        return (q << P) + r;
+    }
+};
+
 #endif // BITCOIN_UTIL_GOLOMBRICE_H
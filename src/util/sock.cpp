@@ -14,11 +14,17 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #ifdef USE_POLL
 #include <poll.h>
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 static inline bool IOErrorIsPermanent(int err)
 {
     return err != WSAEAGAIN && err != WSAEINTR && err != WSAEWOULDBLOCK && err != WSAEINPROGRESS;
@@ -127,6 +133,42 @@ bool Sock::SetNonBlocking() const
     return true;
 }
 
+#ifdef USE_EPOLL
+namespace {
+/**
+ * Per-thread epoll(7) instance used by Sock::WaitMany(). Sockets stay
+ * registered between calls, so that only changes to the requested events
+ * (e.g. a peer's send buffer becoming empty) are passed to the kernel,
+ * instead of the whole set on every call as with poll(2).
+ */
+struct EpollState {
+    struct Registration {
+        //! The Sock registered under this descriptor. A different Sock
+        //! reusing the descriptor number of a closed one is registered again.
+        std::weak_ptr<const Sock> sock;
+        uint32_t events{0};
+        uint64_t generation{0};
+        Sock::Events* waiting{nullptr};
+    };
+
+    const int fd{epoll_create1(EPOLL_CLOEXEC)};
+    std::unordered_map<SOCKET, Registration> registered;
+    std::vector<epoll_event> ready;
+    uint64_t generation{0};
+
+    EpollState() = default;
+    EpollState(const EpollState&) = delete;
+    EpollState& operator=(const EpollState&) = delete;
+    ~EpollState()
+    {
+        if (fd != -1) close(fd);
+    }
+};
+
+thread_local EpollState g_epoll;
+} // namespace
+#endif /* USE_EPOLL */
+
 bool Sock::IsSelectable() const
 {
 #if defined(USE_POLL) || defined(WIN32)
@@ -158,6 +200,77 @@ bool Sock::Wait(std::chrono::milliseconds timeout, Event requested, Event* occur
 
 bool Sock::WaitMany(std::chrono::milliseconds timeout, EventsPerSock& events_per_sock) const
 {
+#ifdef USE_EPOLL
+    // A single socket (e.g. from Wait()) is cheaper to wait on with poll(2).
+    if (events_per_sock.size() > 1 && g_epoll.fd != -1) {
+        auto& state{g_epoll};
+        ++state.generation;
+        bool ok{true};
+        for (auto& [sock, events] : events_per_sock) {
+            const uint32_t want{(events.requested & RECV ? uint32_t{EPOLLIN} : 0) | (events.requested & SEND ? uint32_t{EPOLLOUT} : 0)};
+            auto [it, inserted]{state.registered.try_emplace(sock->m_socket)};
+            auto& reg{it->second};
+            const bool same_sock{!inserted && !reg.sock.owner_before(sock) && !sock.owner_before(reg.sock)};
+            if (!same_sock || reg.events != want) {
+                epoll_event ev{};
+                ev.events = want;
+                ev.data.fd = sock->m_socket;
+                int op{same_sock ? EPOLL_CTL_MOD : EPOLL_CTL_ADD};
+                int ret{epoll_ctl(state.fd, op, sock->m_socket, &ev)};
+                if (ret != 0 && (errno == EEXIST || errno == ENOENT)) {
+                    // Registered through another Sock object for the same
+                    // descriptor, or removed by the kernel after a close().
+                    op = op == EPOLL_CTL_ADD ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+                    ret = epoll_ctl(state.fd, op, sock->m_socket, &ev);
+                }
+                if (ret != 0) {
+                    ok = false;
+                    break;
+                }
+            }
+            reg.sock = sock;
+            reg.events = want;
+            reg.generation = state.generation;
+            reg.waiting = &events;
+            events.occurred = 0;
+        }
+        // Stop watching sockets that are not waited on anymore. Errors are
+        // expected here for descriptors that have been closed already.
+        for (auto it{state.registered.begin()}; it != state.registered.end();) {
+            if (!ok || it->second.generation != state.generation) {
+                (void)epoll_ctl(state.fd, EPOLL_CTL_DEL, it->first, nullptr);
+                it = state.registered.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (ok) {
+            state.ready.resize(events_per_sock.size());
+            const int num_ready{epoll_wait(state.fd, state.ready.data(), state.ready.size(), count_milliseconds(timeout))};
+            if (num_ready == SOCKET_ERROR) {
+                return false;
+            }
+            for (int i = 0; i < num_ready; ++i) {
+                const auto it{state.registered.find(state.ready[i].data.fd)};
+                if (it == state.registered.end()) continue;
+                auto& occurred{it->second.waiting->occurred};
+                if (state.ready[i].events & EPOLLIN) {
+                    occurred |= RECV;
+                }
+                if (state.ready[i].events & EPOLLOUT) {
+                    occurred |= SEND;
+                }
+                if (state.ready[i].events & (EPOLLERR | EPOLLHUP)) {
+                    occurred |= ERR;
+                }
+            }
+            return true;
+        }
+        // Fall back to poll(2) for this call.
+    }
+#endif /* USE_EPOLL */
+
 #ifdef USE_POLL
     std::vector<pollfd> pfds;
     for (const auto& [sock, events] : events_per_sock) {
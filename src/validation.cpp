@@ -2869,8 +2869,9 @@ bool Chainstate::FlushStateToDisk(
             } else {
                 LOG_TIME_MILLIS_WITH_CATEGORY("find files to prune", BCLog::BENCH);
 
-                m_blockman.FindFilesToPrune(setFilesToPrune, last_prune, *this, m_chainman);
+                // FindFilesToPrune sets the flag again if it leaves files for the next flush.
                 m_blockman.m_check_for_pruning = false;
+                m_blockman.FindFilesToPrune(setFilesToPrune, last_prune, *this, m_chainman);
             }
             if (!setFilesToPrune.empty()) {
                 fFlushForPrune = true;
@@ -2923,11 +2924,19 @@ bool Chainstate::FlushStateToDisk(
                     return FatalError(m_chainman.GetNotifications(), state, _("Failed to write to block index database."));
                 }
             }
-            // Finally remove any pruned files
+            // Finally remove any pruned files. Nothing refers to them anymore
+            // now that the block index is written, so automatic pruning does
+            // this in the background without holding cs_main. Manual pruning
+            // (pruneblockchain) removes them before returning, as callers
+            // expect.
             if (fFlushForPrune) {
-                LOG_TIME_MILLIS_WITH_CATEGORY("unlink pruned files", BCLog::BENCH);
+                if (nManualPruneHeight > 0) {
+                    LOG_TIME_MILLIS_WITH_CATEGORY("unlink pruned files", BCLog::BENCH);
 
-                m_blockman.UnlinkPrunedFiles(setFilesToPrune);
+                    m_blockman.UnlinkPrunedFiles(setFilesToPrune);
+                } else {
+                    m_blockman.ScheduleUnlinkPrunedFiles(setFilesToPrune);
+                }
             }
             m_last_write = nNow;
         }